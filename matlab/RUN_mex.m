@@ -12,3 +12,7 @@ run([getenv('AEM_DIR_CORE') filesep 'matlab' filesep 'utilities-3rdparty' filese
 mexDir = [getenv('AEM_DIR_CORE') filesep 'matlab' filesep 'utilities-1stparty' filesep 'runDynamicsFast'];
 eval(sprintf('mex %s -outdir %s',[mexDir filesep 'run_dynamics_fast.c'],mexDir))
 %eval(sprintf('mex -g %s -outdir %s',[mexDir filesep 'run_dynamics_fast.c'],mexDir)) % Uncomment for debugging
+
+% sweep_chunk
+mexDir = [getenv('AEM_DIR_CORE') filesep 'matlab' filesep 'utilities-1stparty' filesep 'sweepIterator'];
+eval(sprintf('mex %s -outdir %s',[mexDir filesep 'sweep_chunk.c'],mexDir))
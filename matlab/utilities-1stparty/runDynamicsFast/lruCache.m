@@ -0,0 +1,147 @@
+classdef lruCache < handle
+    % Copyright 2022, MIT Lincoln Laboratory
+    % SPDX-License-Identifier: BSD-2-Clause
+    %LRUCACHE  Least recently used cache of values keyed by char arrays.
+    %Entries are kept in slots of a doubly linked recency list, most
+    %recently used first, so get, put, and each eviction are O(1).
+    %
+    %  cache = lruCache();
+    %  nEvicted = put(cache,key,value,nBytes,maxBytes)
+    %  [value, isHit] = get(cache,key)
+    %  tf = isKey(cache,key)
+    %
+    % SEE ALSO runDynamicsCached
+
+    properties (SetAccess = private)
+        bytes = 0 % Total bytes of all entries
+    end
+
+    properties (Access = private)
+        slots % containers.Map of key to slot
+        keys = {} % Key of each slot
+        values = {} % Value of each slot
+        sizes = zeros(0,1) % Bytes of each slot
+        prev = zeros(0,1) % Previous (more recent) slot, 0 if head
+        next = zeros(0,1) % Next (less recent) slot, 0 if tail
+        head = 0 % Most recently used slot
+        tail = 0 % Least recently used slot
+        free = zeros(0,1) % Stack of unused slots
+    end
+
+    methods
+        function obj = lruCache()
+            obj.slots = containers.Map('KeyType','char','ValueType','double');
+        end
+
+        function n = count(obj)
+            % Number of entries
+            n = obj.slots.Count;
+        end
+
+        function n = slotCount(obj)
+            % Number of allocated slots, used and free
+            n = numel(obj.prev);
+        end
+
+        function tf = isKey(obj,key)
+            % True if key is cached, without changing its recency
+            tf = isKey(obj.slots,key);
+        end
+
+        function [value, isHit] = get(obj,key)
+            % Returns the value of key and marks it most recently used
+            isHit = isKey(obj.slots,key);
+            if ~isHit
+                value = [];
+                return;
+            end
+            s = obj.slots(key);
+            obj.unlink(s);
+            obj.pushFront(s);
+            value = obj.values{s};
+        end
+
+        function nEvicted = put(obj,key,value,nBytes,maxBytes)
+            % Inserts or replaces key as most recently used, then evicts
+            % least recently used entries until bytes <= maxBytes. Entries
+            % larger than maxBytes are not stored.
+            nEvicted = 0;
+            if nBytes > maxBytes
+                return;
+            end
+
+            if isKey(obj.slots,key)
+                s = obj.slots(key);
+                obj.bytes = obj.bytes - obj.sizes(s);
+                obj.unlink(s);
+            else
+                s = obj.allocate();
+                obj.keys{s} = key;
+                obj.slots(key) = s;
+            end
+            obj.values{s} = value;
+            obj.sizes(s) = nBytes;
+            obj.bytes = obj.bytes + nBytes;
+            obj.pushFront(s);
+
+            while obj.bytes > maxBytes && obj.tail ~= 0
+                s = obj.tail;
+                obj.unlink(s);
+                remove(obj.slots,obj.keys{s});
+                obj.bytes = obj.bytes - obj.sizes(s);
+                obj.keys{s} = '';
+                obj.values{s} = [];
+                obj.free(end+1,1) = s;
+                nEvicted = nEvicted + 1;
+            end
+        end
+    end
+
+    methods (Access = private)
+        function s = allocate(obj)
+            % Returns an unused slot, doubling the number of slots if needed
+            if isempty(obj.free)
+                n = numel(obj.prev);
+                nNew = max(16,2*n);
+                obj.keys(n+1:nNew,1) = {''};
+                obj.values(n+1:nNew,1) = {[]};
+                obj.sizes(n+1:nNew,1) = 0;
+                obj.prev(n+1:nNew,1) = 0;
+                obj.next(n+1:nNew,1) = 0;
+                obj.free = (nNew:-1:n+1)';
+            end
+            s = obj.free(end);
+            obj.free(end) = [];
+        end
+
+        function unlink(obj,s)
+            % Removes slot s from the recency list
+            p = obj.prev(s);
+            n = obj.next(s);
+            if p ~= 0
+                obj.next(p) = n;
+            else
+                obj.head = n;
+            end
+            if n ~= 0
+                obj.prev(n) = p;
+            else
+                obj.tail = p;
+            end
+            obj.prev(s) = 0;
+            obj.next(s) = 0;
+        end
+
+        function pushFront(obj,s)
+            % Inserts slot s at the head of the recency list
+            obj.prev(s) = 0;
+            obj.next(s) = obj.head;
+            if obj.head ~= 0
+                obj.prev(obj.head) = s;
+            else
+                obj.tail = s;
+            end
+            obj.head = s;
+        end
+    end
+end
@@ -0,0 +1,56 @@
+% Copyright 2022, MIT Lincoln Laboratory
+% SPDX-License-Identifier: BSD-2-Clause
+% Test lruCache
+
+%% Get and put
+cache = lruCache();
+[value, isHit] = get(cache,'a');
+assert(~isHit && isempty(value),'Empty cache returned a hit');
+nEvicted = put(cache,'a',1,1,3);
+nEvicted = nEvicted + put(cache,'b',2,1,3);
+nEvicted = nEvicted + put(cache,'c',3,1,3);
+assert(nEvicted == 0 && count(cache) == 3 && cache.bytes == 3,'Entries under the cap were evicted');
+[value, isHit] = get(cache,'b');
+assert(isHit && value == 2,'Wrong value returned');
+
+%% Eviction of the tail
+% Recency is now b, c, a; getting a makes c the least recently used
+get(cache,'a');
+nEvicted = put(cache,'d',4,1,3);
+assert(nEvicted == 1 && count(cache) == 3,'Exactly one entry should be evicted');
+[~, isHit] = get(cache,'c');
+assert(~isHit,'Least recently used entry was not evicted');
+assert(all(cellfun(@(k) isKey(cache,k),{'a','b','d'})),'Wrong entry evicted');
+
+%% Order after a re-put
+% Recency is d, a, b; re-putting b makes a the least recently used
+nEvicted = put(cache,'b',20,1,3);
+assert(nEvicted == 0 && count(cache) == 3 && cache.bytes == 3,'Re-put changed the number of entries');
+put(cache,'e',5,1,3);
+assert(~isKey(cache,'a'),'Re-put entry did not become most recently used');
+[value, isHit] = get(cache,'b');
+assert(isHit && value == 20,'Re-put did not replace the value');
+
+% Recency is b, e, d; a larger re-put of e evicts d from the tail
+nEvicted = put(cache,'e',5,2,3);
+assert(nEvicted == 1 && cache.bytes == 3 && isKey(cache,'e') && ~isKey(cache,'d'),'Re-put size not accounted for');
+
+%% Reuse of freed slots
+cache = lruCache();
+for ii=1:1:1000
+    put(cache,sprintf('k%i',ii),ii,1,10);
+end
+assert(count(cache) == 10 && cache.bytes == 10,'Cache exceeded its cap');
+assert(slotCount(cache) == 16,'Freed slots were not reused');
+for ii=991:1:1000
+    [value, isHit] = get(cache,sprintf('k%i',ii));
+    assert(isHit && value == ii,'Most recent entries were not kept');
+end
+
+%% Entries larger than the cap are not stored
+cache = lruCache();
+put(cache,'a',1,1,3);
+nEvicted = put(cache,'big',2,4,3);
+assert(nEvicted == 0 && ~isKey(cache,'big') && isKey(cache,'a'),'Oversized entry was stored');
+put(cache,'a',1,1,0);
+assert(count(cache) == 1,'Zero cap put modified the cache');
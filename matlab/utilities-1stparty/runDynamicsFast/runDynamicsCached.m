@@ -0,0 +1,278 @@
+function varargout = runDynamicsCached(varargin)
+% Copyright 2022, MIT Lincoln Laboratory
+% SPDX-License-Identifier: BSD-2-Clause
+%RUNDYNAMICSCACHED  Runs run_dynamics_fast, serving repeated encounters
+%from a content-addressed cache. The cache key is a SHA-256 hash of the
+%canonicalized inputs and the run_dynamics_fast engine version, so cached
+%outputs are invalidated when the engine changes.
+%
+%  Outputs are in the same order as run_dynamics_fast. STATS is always
+%  cached. RESULTS is only cached and returned when saveResults is true;
+%  otherwise RESULTS is always empty, on a hit or a miss, so the outputs
+%  never depend on the cache state. A cached entry without RESULTS is
+%  rerun when saveResults is true.
+%
+%  Outputs are always cached in memory, up to maxMemoryBytes. If cacheDir
+%  is specified, outputs are also cached on disk as compressed MAT-files,
+%  sharded into subdirectories by the first two characters of the key, and
+%  shared by all workers on the machine using the same directory. Both
+%  caches evict the least recently used entries. Each worker evicts the
+%  disk cache in a batch, down to 90% of maxBytes, after it has written
+%  evictFraction * maxBytes since its last eviction, with the size of each
+%  file rounded up to blockBytes. The disk cap is therefore approximate:
+%  with N workers it can be exceeded by up to N * evictFraction * maxBytes.
+%  Temporary files older than an hour, left by crashed workers, are removed
+%  during eviction.
+%
+%  [RESULTS, STATS] = runDynamicsCached(init1,c1,dyn1,init2,c2,dyn2,runtime_s)
+%  [RESULTS, STATS] = runDynamicsCached(init1,c1,dyn1,init2,c2,dyn2,runtime_s,opt)
+%  [~, STATS] = runDynamicsCached(...,'cacheDir',cacheDir,'maxBytes',1e9)
+%  [RESULTS, STATS] = runDynamicsCached(...,'saveResults',true)
+%  info = runDynamicsCached('stats') % Hit, miss, and eviction counts
+%  runDynamicsCached('reset') % Clear memory cache and counts
+%
+% SEE ALSO run_dynamics_fast lruCache runDynamicsSweep
+
+persistent memCache engineVersion info bytesSinceEvict lastOptArgs opts
+
+if ~isa(memCache,'lruCache') || (nargin == 1 && strcmpi(varargin{1},'reset'))
+    memCache = lruCache();
+    info = struct('hits',0,'misses',0,'memoryHits',0,'diskHits',0,'memoryEvictions',0,'diskEvictions',0);
+    bytesSinceEvict = inf; % Evict on first disk store
+end
+
+%% Control calls
+if nargin == 1 && ischar(varargin{1})
+    switch lower(varargin{1})
+        case 'stats'
+            varargout{1} = info;
+        case 'reset'
+            % Already reset above
+        otherwise
+            error('runDynamicsCached:mode','Unknown mode %s, expected stats or reset',varargin{1});
+    end
+    return;
+end
+
+%% Input parser
+iOpt = nargin + 1;
+for ii=1:1:nargin
+    if ischar(varargin{ii})
+        iOpt = ii;
+        break;
+    end
+end
+inputs = varargin(1:iOpt-1);
+assert(numel(inputs) == 7 || numel(inputs) == 8,'Seven or eight run_dynamics_fast inputs required');
+
+% Options are usually identical across calls, so only parse when they change
+optArgs = varargin(iOpt:end);
+if isempty(opts) || ~isequal(optArgs,lastOptArgs)
+    p = inputParser;
+
+    % Optional - Cache
+    addParameter(p,'cacheDir','',@ischar);
+    addParameter(p,'maxBytes',1e9,@(x) isnumeric(x) && numel(x) == 1 && x >= 0);
+    addParameter(p,'maxMemoryBytes',256e6,@(x) isnumeric(x) && numel(x) == 1 && x >= 0);
+    addParameter(p,'blockBytes',4096,@(x) isnumeric(x) && numel(x) == 1 && x >= 1);
+    addParameter(p,'evictFraction',0.01,@(x) isnumeric(x) && numel(x) == 1 && x > 0 && x <= 1);
+    addParameter(p,'saveResults',false,@islogical);
+
+    % Parse
+    parse(p,optArgs{:});
+    opts = p.Results;
+    lastOptArgs = optArgs;
+end
+cacheDir = opts.cacheDir;
+isSaveResults = opts.saveResults;
+
+if isempty(engineVersion)
+    engineVersion = run_dynamics_fast();
+end
+
+%% Compute key
+key = hashInputs(inputs,engineVersion);
+
+%% Memory cache
+[entry, isHit] = get(memCache,key);
+if isHit && (~isSaveResults || isfield(entry,'RESULTS'))
+    info.hits = info.hits + 1;
+    info.memoryHits = info.memoryHits + 1;
+    varargout = outputs(entry,isSaveResults,nargout);
+    return;
+end
+
+%% Disk cache
+if ~isempty(cacheDir)
+    cacheFile = [cacheDir filesep key(1:2) filesep key '.mat'];
+    entry = struct();
+    if isfile(cacheFile)
+        try
+            if isSaveResults
+                entry = load(cacheFile);
+            else
+                entry = load(cacheFile,'STATS');
+            end
+        catch
+            % Another worker evicted or is replacing the file, treat as miss
+        end
+    end
+
+    if isfield(entry,'STATS') && (~isSaveResults || isfield(entry,'RESULTS'))
+        % Update modification time, which is used for LRU eviction
+        java.io.File(cacheFile).setLastModified(java.lang.System.currentTimeMillis());
+
+        info.hits = info.hits + 1;
+        info.diskHits = info.diskHits + 1;
+        info.memoryEvictions = info.memoryEvictions + storeMemory(memCache,key,entry,opts.maxMemoryBytes);
+        varargout = outputs(entry,isSaveResults,nargout);
+        return;
+    end
+end
+
+%% Cache miss, run dynamics
+info.misses = info.misses + 1;
+[RESULTS, STATS] = run_dynamics_fast(inputs{:});
+
+entry = struct('STATS',STATS);
+if isSaveResults
+    entry.RESULTS = RESULTS;
+end
+info.memoryEvictions = info.memoryEvictions + storeMemory(memCache,key,entry,opts.maxMemoryBytes);
+
+if ~isempty(cacheDir)
+    bytesSinceEvict = bytesSinceEvict + storeDisk(entry,cacheDir,key,opts.blockBytes);
+    if bytesSinceEvict >= opts.evictFraction * opts.maxBytes
+        info.diskEvictions = info.diskEvictions + evictDisk(cacheDir,opts.maxBytes,opts.blockBytes);
+        bytesSinceEvict = 0;
+    end
+end
+
+varargout = outputs(entry,isSaveResults,nargout);
+end
+
+function nEvicted = storeMemory(memCache,key,entry,maxMemoryBytes)
+% Adds entry to the memory cache, evicting least recently used entries
+if maxMemoryBytes <= 0
+    nEvicted = 0;
+    return;
+end
+if isfield(entry,'RESULTS')
+    w = whos('entry');
+    nBytes = w.bytes;
+else
+    nBytes = 8 * numel(entry.STATS) + 256; % STATS plus approximate overhead
+end
+nEvicted = put(memCache,key,entry,nBytes,maxMemoryBytes);
+end
+
+function nBytes = storeDisk(entry,cacheDir,key,blockBytes)
+% Writes to a unique temporary file and renames it into place, so
+% concurrent workers never load a partially written entry. Returns the
+% size of the file rounded up to whole blocks.
+shardDir = [cacheDir filesep key(1:2)];
+if ~isfolder(shardDir)
+    [~, ~] = mkdir(shardDir); % Another worker may create it concurrently
+end
+[~, tmpName] = fileparts(tempname);
+tmpFile = [shardDir filesep key '_' tmpName '.tmp'];
+save(tmpFile,'-struct','entry','-v7');
+nBytes = max(ceil(java.io.File(tmpFile).length() / blockBytes),1) * blockBytes;
+isMoved = movefile(tmpFile,[shardDir filesep key '.mat'],'f');
+if ~isMoved
+    java.io.File(tmpFile).delete();
+end
+end
+
+function nEvicted = evictDisk(cacheDir,maxBytes,blockBytes)
+% Evicts least recently used entries, in a batch down to 90% of maxBytes,
+% and removes stale temporary files. Sizes are rounded up to whole blocks
+% because every small MAT-file occupies at least one filesystem block.
+nEvicted = 0;
+listing = dir([cacheDir filesep '*' filesep '*.*']);
+listing = listing(~[listing.isdir]);
+if isempty(listing)
+    return;
+end
+names = strcat({listing.folder},filesep,{listing.name});
+blocks = max(ceil([listing.bytes] / blockBytes),1) * blockBytes;
+isTmp = endsWith({listing.name},'.tmp');
+isMat = endsWith({listing.name},'.mat');
+
+% Remove temporary files abandoned by crashed workers
+isStale = isTmp & [listing.datenum] < now - 1/24;
+for ii=find(isStale)
+    java.io.File(names{ii}).delete();
+end
+totalBytes = sum(blocks(~isStale & (isTmp | isMat)));
+
+% Evict least recently used entries
+if totalBytes > maxBytes
+    iMat = find(isMat);
+    [~, iSort] = sort([listing(iMat).datenum]);
+    for ii=iMat(iSort)
+        if totalBytes <= 0.9 * maxBytes
+            break;
+        end
+        % Only true if this worker deleted the file, another worker may
+        % have already evicted it
+        if java.io.File(names{ii}).delete()
+            nEvicted = nEvicted + 1;
+        end
+        totalBytes = totalBytes - blocks(ii);
+    end
+end
+end
+
+function out = outputs(entry,isSaveResults,nout)
+% Returns RESULTS and STATS from a cache entry, in run_dynamics_fast order
+if isSaveResults
+    out = {entry.RESULTS, entry.STATS};
+else
+    out = {[], entry.STATS};
+end
+out = out(1:max(nout,1));
+end
+
+function key = hashInputs(inputs,engineVersion)
+% Canonicalizes the run_dynamics_fast inputs and hashes them with SHA-256.
+% Only the elements read by run_dynamics_fast are hashed and omitted
+% options are replaced by their run_dynamics_fast defaults.
+persistent md hex
+if isempty(md)
+    md = java.security.MessageDigest.getInstance('SHA-256');
+    hex = '0123456789abcdef';
+end
+
+NUM_INIT = 8;
+NUM_DYN = 6;
+if numel(inputs) == 7
+    inputs{8} = [0 1e6 1e6 0 0 0];
+end
+inputs{1} = inputs{1}(1:NUM_INIT);
+inputs{4} = inputs{4}(1:NUM_INIT);
+inputs{3} = inputs{3}(1:NUM_DYN);
+inputs{6} = inputs{6}(1:NUM_DYN);
+inputs{7} = inputs{7}(1);
+inputs{8} = inputs{8}(1:6);
+
+% Prefix each input with its size, controls are a matrix
+values = cell(1,2*numel(inputs));
+for ii=1:1:numel(inputs)
+    x = double(inputs{ii});
+    if ii == 2 || ii == 5
+        sz = size(x);
+    else
+        sz = numel(x);
+    end
+    values{2*ii-1} = [numel(sz), sz];
+    values{2*ii} = x(:)';
+end
+x = [double(engineVersion), values{:}];
+x(x == 0) = 0; % Treat -0 and 0 as identical
+
+digest = double(typecast(md.digest(typecast(x,'int8')),'uint8'));
+digest = digest(:)';
+key = hex([floor(digest / 16); mod(digest,16)] + 1);
+key = key(:)';
+end
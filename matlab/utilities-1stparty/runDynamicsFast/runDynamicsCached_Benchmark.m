@@ -0,0 +1,43 @@
+% Copyright 2022, MIT Lincoln Laboratory
+% SPDX-License-Identifier: BSD-2-Clause
+% Benchmark runDynamicsCached hits against rerunning run_dynamics_fast
+init1 = [200 0 0 1000 0 0 0 0];
+init2 = [200 50000 0 1000 pi 0 0 0];
+c = [0 0 0 0];
+dyn = [1.7 1116 -10000 10000 3*pi/180 1e6];
+runtimes_s = [10 60 300];
+nTrials = 1000;
+
+cacheDir = tempname;
+t = zeros(numel(runtimes_s),3);
+for ii=1:1:numel(runtimes_s)
+    args = {init1, c, dyn, init2, c, dyn, runtimes_s(ii)};
+
+    % Rerun
+    tic;
+    for jj=1:1:nTrials
+        [~, STATS] = run_dynamics_fast(args{:});
+    end
+    t(ii,1) = toc / nTrials;
+
+    % Memory hit
+    runDynamicsCached('reset');
+    [~, STATS] = runDynamicsCached(args{:});
+    tic;
+    for jj=1:1:nTrials
+        [~, STATS] = runDynamicsCached(args{:});
+    end
+    t(ii,2) = toc / nTrials;
+
+    % Disk hit, with the memory cache disabled
+    [~, STATS] = runDynamicsCached(args{:},'cacheDir',cacheDir,'maxMemoryBytes',0);
+    tic;
+    for jj=1:1:nTrials
+        [~, STATS] = runDynamicsCached(args{:},'cacheDir',cacheDir,'maxMemoryBytes',0);
+    end
+    t(ii,3) = toc / nTrials;
+end
+rmdir(cacheDir,'s');
+runDynamicsCached('reset');
+
+disp(array2table(1e6 * t,'VariableNames',{'rerun_us','memory_hit_us','disk_hit_us'},'RowNames',cellstr(num2str(runtimes_s','runtime_s = %i'))));
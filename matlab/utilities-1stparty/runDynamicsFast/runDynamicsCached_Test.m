@@ -0,0 +1,121 @@
+% Copyright 2022, MIT Lincoln Laboratory
+% SPDX-License-Identifier: BSD-2-Clause
+% Test runDynamicsCached
+init1 = [200 0 0 1000 0 0 0 0];
+init2 = [200 50000 0 1000 pi 0 0 0];
+c = [0 0 0 0];
+dyn = [1.7 1116 -10000 10000 3*pi/180 1e6];
+args = {init1, c, dyn, init2, c, dyn, 10};
+[RESULTS, STATS] = run_dynamics_fast(args{:});
+
+%% Canonical keys
+runDynamicsCached('reset');
+[R, S] = runDynamicsCached(args{:});
+info = runDynamicsCached('stats');
+assert(info.misses == 1 && info.hits == 0,'First call was not a miss');
+assert(isequal(S,STATS) && isempty(R),'Outputs do not match run_dynamics_fast');
+
+% Omitted options are the run_dynamics_fast defaults
+[~, S] = runDynamicsCached(args{:},[0 1e6 1e6 0 0 0]);
+info = runDynamicsCached('stats');
+assert(info.memoryHits == 1 && info.misses == 1,'7 and 8 input calls do not share a key');
+assert(isequal(S,STATS),'Cached STATS do not match run_dynamics_fast');
+
+% -0 and 0 are identical, and elements not read by run_dynamics_fast are ignored
+argsZero = args;
+argsZero{1}(5) = -0;
+argsZero{3} = [dyn 99];
+[~, S] = runDynamicsCached(argsZero{:});
+info = runDynamicsCached('stats');
+assert(info.memoryHits == 2 && info.misses == 1,'Equivalent inputs do not share a key');
+
+% Different inputs do not share a key
+argsOther = args;
+argsOther{7} = 11;
+[~, S] = runDynamicsCached(argsOther{:});
+info = runDynamicsCached('stats');
+assert(info.misses == 2 && ~isequal(S,STATS),'Different inputs share a key');
+
+%% RESULTS
+% A STATS-only entry is rerun when RESULTS are requested
+[R, S] = runDynamicsCached(args{:},'saveResults',true);
+info = runDynamicsCached('stats');
+assert(info.misses == 3,'STATS-only entry was not rerun for RESULTS');
+assert(isequal(R,RESULTS) && isequal(S,STATS),'Outputs do not match run_dynamics_fast');
+[R, S] = runDynamicsCached(args{:},'saveResults',true);
+info = runDynamicsCached('stats');
+assert(info.misses == 3 && info.memoryHits == 3,'Entry with RESULTS was not a hit');
+assert(isequal(R,RESULTS) && isequal(S,STATS),'Cached RESULTS do not match run_dynamics_fast');
+
+% Without saveResults, RESULTS is empty even when cached
+[R, ~] = runDynamicsCached(args{:});
+assert(isempty(R),'RESULTS returned without saveResults');
+
+%% Disk cache
+cacheDir = tempname;
+runDynamicsCached('reset');
+runDynamicsCached(args{:},'cacheDir',cacheDir);
+runDynamicsCached('reset'); % Clear memory cache so the next call reads from disk
+[~, S] = runDynamicsCached(args{:},'cacheDir',cacheDir);
+info = runDynamicsCached('stats');
+assert(info.diskHits == 1 && info.memoryHits == 0 && info.misses == 0,'Disk entry was not a hit');
+assert(isequal(S,STATS),'Disk STATS do not match run_dynamics_fast');
+[~, ~] = runDynamicsCached(args{:},'cacheDir',cacheDir);
+info = runDynamicsCached('stats');
+assert(info.diskHits == 1 && info.memoryHits == 1,'Disk hit was not stored in memory');
+
+% STATS-only disk entry is rerun when RESULTS are requested
+runDynamicsCached('reset');
+[R, ~] = runDynamicsCached(args{:},'cacheDir',cacheDir,'saveResults',true);
+info = runDynamicsCached('stats');
+assert(info.misses == 1 && isequal(R,RESULTS),'STATS-only disk entry was not rerun for RESULTS');
+rmdir(cacheDir,'s');
+
+%% Memory eviction
+runDynamicsCached('reset');
+entryBytes = 8 * numel(STATS) + 256;
+for ii=1:1:5
+    argsOther{7} = ii;
+    runDynamicsCached(argsOther{:},'maxMemoryBytes',3 * entryBytes);
+end
+info = runDynamicsCached('stats');
+assert(info.memoryEvictions == 2 && info.diskEvictions == 0,'Memory cache not evicted to its cap');
+argsOther{7} = 1;
+runDynamicsCached(argsOther{:},'maxMemoryBytes',3 * entryBytes);
+info = runDynamicsCached('stats');
+assert(info.misses == 6,'Least recently used memory entry was not evicted');
+
+% A zero cap disables the memory cache
+runDynamicsCached('reset');
+runDynamicsCached(args{:},'maxMemoryBytes',0);
+runDynamicsCached(args{:},'maxMemoryBytes',0);
+info = runDynamicsCached('stats');
+assert(info.misses == 2 && info.hits == 0,'Memory cache used with a zero cap');
+
+%% Disk eviction
+cacheDir = tempname;
+blockBytes = 4096;
+maxBytes = 20 * blockBytes;
+runDynamicsCached('reset');
+for ii=1:1:50
+    argsOther{7} = ii;
+    runDynamicsCached(argsOther{:},'cacheDir',cacheDir,'maxBytes',maxBytes, ...
+        'blockBytes',blockBytes,'evictFraction',1e-6,'maxMemoryBytes',0);
+end
+listing = dir([cacheDir filesep '*' filesep '*.mat']);
+diskBytes = sum(max(ceil([listing.bytes] / blockBytes),1) * blockBytes);
+info = runDynamicsCached('stats');
+assert(diskBytes <= maxBytes,'Disk cache exceeds its cap');
+assert(info.diskEvictions == 50 - numel(listing),'Disk evictions not counted');
+assert(info.memoryEvictions == 0,'Disk evictions counted as memory evictions');
+
+% Stale temporary files are removed during eviction
+tmpFile = [listing(1).folder filesep 'stale.tmp'];
+fclose(fopen(tmpFile,'w'));
+java.io.File(tmpFile).setLastModified(java.lang.System.currentTimeMillis() - 2 * 3600 * 1000);
+argsOther{7} = 51;
+runDynamicsCached(argsOther{:},'cacheDir',cacheDir,'maxBytes',maxBytes, ...
+    'blockBytes',blockBytes,'evictFraction',1e-6,'maxMemoryBytes',0);
+assert(~isfile(tmpFile),'Stale temporary file was not removed');
+rmdir(cacheDir,'s');
+runDynamicsCached('reset');
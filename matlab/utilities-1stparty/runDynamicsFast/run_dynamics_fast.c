@@ -25,8 +25,13 @@
 #define NUM_DYN 6  /* Number of dynamic limit variables */
 
 /* Output Arguments */
-#define RESULTS plhs[0] /* RESULTS */
-#define STATS plhs[1]   /* STATS */
+#define RESULTS plhs[0]     /* RESULTS */
+#define STATS plhs[1]       /* STATS */
+#define OUT_VERSION plhs[0] /* Engine version, when called without inputs */
+
+/* Engine version, increment whenever a change alters RESULTS or STATS so that
+   cached outputs (see runDynamicsCached) are invalidated */
+#define ENGINE_VERSION 1
 
 /* Constants */
 #define dt 0.1 /* Time step [s] */
@@ -230,6 +235,14 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
   fieldnames[OUT_THETA] = "theta_rad";
   fieldnames[OUT_PSI] = "psi_rad";
 
+  if (nrhs == 0) { /* Return engine version */
+    OUT_VERSION = mxCreateDoubleScalar(ENGINE_VERSION);
+    return;
+  }
+  if (nrhs < 7) {
+    mexErrMsgTxt("More input arguments required.");
+  }
+
   /* Get pointers to inputs     */
   ptri = mxGetPr(IN_INIT_1);
   ptri2 = mxGetPr(IN_INIT_2);
@@ -238,10 +251,6 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
   ptrd = mxGetPr(IN_DYN_1);
   ptrd2 = mxGetPr(IN_DYN_2);
   ptrr = mxGetPr(IN_R);
-
-  if (nrhs < 7) {
-    mexErrMsgTxt("More input arguments required.");
-  }
   if (nrhs == 8) { /* If input parameters specified */
     if (mxGetN(IN_OPT) < 6)
       mexErrMsgTxt(
@@ -0,0 +1,96 @@
+function [STATS, idx] = runDynamicsSweep(grids,buildInputs,varargin)
+% Copyright 2022, MIT Lincoln Laboratory
+% SPDX-License-Identifier: BSD-2-Clause
+%RUNDYNAMICSSWEEP  Simulates every encounter of a parameter sweep with
+%run_dynamics_fast, streaming the Cartesian product of the grids in chunks
+%from sweep_chunk instead of materializing it with allcomb.
+%
+%  buildInputs is a function handle that takes one row of the product and
+%  returns a 1x7 or 1x8 cell array of run_dynamics_fast inputs,
+%  {init1,c1,dyn1,init2,c2,dyn2,runtime_s,opt}. STATS is a n x 3 matrix of
+%  the run_dynamics_fast STATS output and idx is the linear index of each
+%  row into allcomb(grids{:}). If chunkFcn is specified, it is called as
+%  chunkFcn(STATS,idx) after each chunk and nothing is accumulated, so
+%  arbitrarily large sweeps can be written out as they run. Workers can
+%  resume or shard a sweep with start, count, and stride. If useCache is
+%  true, each encounter is run through runDynamicsCached, with its disk
+%  cache in cacheDir if specified, so encounters repeated within or across
+%  sweeps are not simulated again.
+%
+%  [STATS, idx] = runDynamicsSweep(grids,buildInputs)
+%  [STATS, idx] = runDynamicsSweep(grids,buildInputs,'start',1e6,'count',1e5)
+%  [STATS, idx] = runDynamicsSweep(grids,buildInputs,'start',w,'stride',nWorkers)
+%  runDynamicsSweep(grids,buildInputs,'seed',42,'chunkFcn',@(s,i) save(...))
+%  [STATS, idx] = runDynamicsSweep(grids,buildInputs,'useCache',true,'cacheDir',cacheDir)
+%
+% SEE ALSO sweep_chunk run_dynamics_fast runDynamicsCached allcomb
+
+%% Input parser
+p = inputParser;
+
+% Required
+addRequired(p,'grids',@iscell);
+addRequired(p,'buildInputs',@(x) isa(x,'function_handle'));
+
+% Optional - Sweep
+addParameter(p,'start',1,@(x) isnumeric(x) && numel(x) == 1 && x >= 1);
+addParameter(p,'count',inf,@(x) isnumeric(x) && numel(x) == 1 && x >= 0);
+addParameter(p,'stride',1,@(x) isnumeric(x) && numel(x) == 1 && x >= 1);
+addParameter(p,'seed',0,@(x) isnumeric(x) && numel(x) == 1 && x >= 0);
+addParameter(p,'chunkSize',1e4,@(x) isnumeric(x) && numel(x) == 1 && x >= 1);
+
+% Optional - Cache
+addParameter(p,'useCache',false,@islogical);
+addParameter(p,'cacheDir','',@ischar);
+
+% Optional - Output
+addParameter(p,'chunkFcn',[],@(x) isempty(x) || isa(x,'function_handle'));
+
+% Parse
+parse(p,grids,buildInputs,varargin{:});
+
+grids = cellfun(@(x) double(x(:)'),grids,'UniformOutput',false);
+stride = p.Results.stride;
+chunkSize = p.Results.chunkSize;
+isAccumulate = isempty(p.Results.chunkFcn);
+isCache = p.Results.useCache;
+if isempty(p.Results.cacheDir)
+    cacheArgs = {};
+else
+    cacheArgs = {'cacheDir',p.Results.cacheDir};
+end
+
+%% Iterate over chunks
+STATS = zeros(0,3);
+idx = zeros(0,1);
+pos = p.Results.start;
+remain = p.Results.count;
+while remain > 0
+    [C, idxChunk] = sweep_chunk(grids,pos,min(chunkSize,remain),[stride, p.Results.seed]);
+    n = size(C,1);
+    if n == 0
+        break;
+    end
+
+    % Simulate each encounter in the chunk
+    statsChunk = zeros(n,3);
+    for i=1:1:n
+        args = buildInputs(C(i,:));
+        if isCache
+            [~, s] = runDynamicsCached(args{:},cacheArgs{:});
+        else
+            [~, s] = run_dynamics_fast(args{:});
+        end
+        statsChunk(i,:) = s';
+    end
+
+    if isAccumulate
+        STATS = [STATS; statsChunk]; %#ok<AGROW>
+        idx = [idx; idxChunk]; %#ok<AGROW>
+    else
+        p.Results.chunkFcn(statsChunk,idxChunk);
+    end
+
+    pos = pos + n * stride;
+    remain = remain - n;
+end
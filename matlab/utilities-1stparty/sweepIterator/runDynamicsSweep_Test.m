@@ -0,0 +1,46 @@
+% Copyright 2022, MIT Lincoln Laboratory
+% SPDX-License-Identifier: BSD-2-Clause
+% Test runDynamicsSweep
+% Each row sets runtime_s of a head-on encounter that never breaks out, so
+% the first STATS column, the stop time, is the sum of the row
+grids = {0:1:9, [0.5 1]};
+init1 = [200 0 0 1000 0 0 0 0];
+init2 = [200 50000 0 1000 pi 0 0 0];
+c = [0 0 0 0];
+dyn = [1.7 1116 -10000 10000 3*pi/180 1e6];
+buildInputs = @(row) {init1, c, dyn, init2, c, dyn, sum(row)};
+A = allcomb(grids{:});
+
+%% Full sweep in chunks smaller than the sweep
+[STATS, idx] = runDynamicsSweep(grids,buildInputs,'chunkSize',3);
+assert(isequal(idx,(1:size(A,1))'),'Full sweep does not visit every row in order');
+assert(all(abs(STATS(:,1) - sum(A,2)) < 1e-9),'STATS do not match the sweep rows');
+
+%% Resume with a stride across chunk boundaries
+[STATS, idx] = runDynamicsSweep(grids,buildInputs,'start',4,'count',5,'stride',2,'chunkSize',2);
+[~, idxExpected] = sweep_chunk(grids,4,5,[2 0]);
+assert(isequal(idx,idxExpected),'Strided resume does not match sweep_chunk');
+assert(all(abs(STATS(:,1) - sum(A(idx,:),2)) < 1e-9),'Strided STATS do not match the sweep rows');
+
+% Count past the end of the sweep is truncated
+[~, idx] = runDynamicsSweep(grids,buildInputs,'start',18,'count',10,'chunkSize',2);
+assert(isequal(idx,(18:20)'),'Sweep does not stop at the last row');
+
+%% chunkFcn receives every chunk and nothing is accumulated
+tmpDir = tempname;
+mkdir(tmpDir);
+chunkFcn = @(s,i) save([tmpDir filesep sprintf('chunk_%06i.mat',i(1))],'s','i');
+[STATS, idx] = runDynamicsSweep(grids,buildInputs,'seed',42,'chunkSize',6,'chunkFcn',chunkFcn);
+assert(isempty(STATS) && isempty(idx),'Outputs accumulated with chunkFcn');
+
+listing = dir([tmpDir filesep 'chunk_*.mat']);
+assert(numel(listing) == ceil(size(A,1) / 6),'chunkFcn not called once per chunk');
+idx = [];
+for ii=1:1:numel(listing)
+    chunk = load([tmpDir filesep listing(ii).name]);
+    assert(size(chunk.s,1) == numel(chunk.i),'Chunk STATS and indices differ in size');
+    assert(all(abs(chunk.s(:,1) - sum(A(chunk.i,:),2)) < 1e-9),'Chunk STATS do not match the sweep rows');
+    idx = [idx; chunk.i]; %#ok<AGROW>
+end
+assert(isequal(sort(idx),(1:size(A,1))'),'Seeded sweep does not visit every row exactly once');
+rmdir(tmpDir,'s');
@@ -0,0 +1,189 @@
+/* Copyright 2022, MIT Lincoln Laboratory
+% SPDX-License-Identifier: BSD-2-Clause */
+
+/* SWEEP_CHUNK  Returns a chunk of rows of the Cartesian product of the
+   inputted grids without materializing the full product. In natural order
+   with a stride of one, position k (1-based) is identical to row k of
+   allcomb(GRIDS{:}), i.e. the last grid changes fastest.
+
+   C = sweep_chunk(GRIDS,START,COUNT)
+   C = sweep_chunk(GRIDS,START,COUNT,OPT)
+   [C,IDX] = sweep_chunk(...)
+
+   GRIDS is a 1xD cell array of numeric vectors. START is the 1-based position
+   of the first row to return and COUNT is the maximum number of rows; fewer
+   rows are returned when the end of the sweep is reached. OPT is
+   [stride,seed]: positions START, START+stride, ... are returned, and a
+   nonzero seed visits the product in a pseudo-random permutation order
+   instead of the natural order. Every position maps to its row in O(D), so a
+   worker can resume from any position. IDX is the linear index of each row
+   into allcomb(GRIDS{:}). */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "matrix.h"
+#include "mex.h"
+
+/* Input Arguments */
+#define IN_GRIDS prhs[0] /* cell array of grid vectors */
+#define IN_START prhs[1] /* first position (1-based) */
+#define IN_COUNT prhs[2] /* maximum number of rows */
+#define IN_OPT prhs[3]   /* options in [stride,seed] */
+
+/* Output Arguments */
+#define OUT_C plhs[0]   /* rows of the Cartesian product */
+#define OUT_IDX plhs[1] /* linear index of each row */
+
+/* Constants */
+#define MAX_INDEX 9007199254740992.0 /* flintmax, largest exact double index */
+#define NUM_ROUNDS 6 /* Number of Feistel rounds for the permutation order */
+
+/* Steps the splitmix64 generator, used to derive keys and mix Feistel rounds */
+static uint64_T splitmix64(uint64_T *state) {
+  uint64_T z;
+
+  *state += 0x9E3779B97F4A7C15ULL;
+  z = *state;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/* Feistel round function, mixes the right half with the round key */
+static uint64_T feistel_round(uint64_T r, uint64_T key) {
+  uint64_T state = r ^ key;
+
+  return splitmix64(&state);
+}
+
+/* Keyed bijection on [0,total). A balanced Feistel network permutes
+   [0,2^(2*half)), the smallest even power of two >= total, and positions that
+   map outside [0,total) are cycle-walked back into it. Because the domain is at
+   most 4*total, fewer than four walks are expected per position. */
+static uint64_T permute_index(uint64_T pos, uint64_T total, unsigned int half,
+                              const uint64_T keys[]) {
+  uint64_T mask = ((uint64_T)1 << half) - 1, l, r, t;
+  unsigned int k;
+
+  do {
+    l = pos >> half;
+    r = pos & mask;
+    for (k = 0; k < NUM_ROUNDS; k++) {
+      t = r;
+      r = l ^ (feistel_round(r, keys[k]) & mask);
+      l = t;
+    }
+    pos = (l << half) | r;
+  } while (pos >= total);
+  return pos;
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+
+{
+  const mxArray *grid; /* Current grid */
+
+  mwSize ndims, /* Number of grids */
+      nrows,    /* Number of rows returned */
+      *gridn;   /* Number of elements in each grid */
+
+  double **ptrgrid, /* Pointer to each grid */
+      *ptropt, *ptrc, *ptridx;
+
+  double start, count, /* Requested position and number of rows */
+      ntotal = 1;      /* Number of rows in the full product */
+
+  uint64_T total,  /* Number of rows in the full product */
+      pos,         /* Current 0-based position */
+      stride = 1,  /* Step between positions */
+      seed = 0,    /* Permutation seed, zero for natural order */
+      keys[NUM_ROUNDS], /* Feistel round keys */
+      remain, lin;      /* Remaining positions and current linear index */
+
+  mwSize i, d; /* Dummy indices */
+
+  unsigned int permute = 0, /* Visit in permutation order */
+      half = 0,             /* Bits in each half of the Feistel domain */
+      k;
+
+  if (nrhs < 3) {
+    mexErrMsgTxt("More input arguments required.");
+  }
+  if (!mxIsCell(IN_GRIDS)) {
+    mexErrMsgTxt("First input must be a cell array of grid vectors.");
+  }
+  if (nrhs == 4) { /* If options specified */
+    if (!mxIsDouble(IN_OPT) || mxIsComplex(IN_OPT))
+      mexErrMsgTxt("Input options vector must be real double.");
+    if (mxGetNumberOfElements(IN_OPT) < 2)
+      mexErrMsgTxt("Two elements required in input options vector.");
+    ptropt = mxGetPr(IN_OPT);
+    if (!(*(ptropt + 0) >= 1 && *(ptropt + 0) <= MAX_INDEX) ||
+        *(ptropt + 0) != floor(*(ptropt + 0)))
+      mexErrMsgTxt("Stride must be a positive integer.");
+    if (!(*(ptropt + 1) >= 0 && *(ptropt + 1) <= MAX_INDEX) ||
+        *(ptropt + 1) != floor(*(ptropt + 1)))
+      mexErrMsgTxt("Seed must be a nonnegative integer.");
+    stride = (uint64_T) * (ptropt + 0);
+    seed = (uint64_T) * (ptropt + 1);
+  }
+
+  start = mxGetScalar(IN_START);
+  count = mxGetScalar(IN_COUNT);
+  if (!(start >= 1 && start <= MAX_INDEX) || start != floor(start))
+    mexErrMsgTxt("Start position must be a positive integer.");
+  if (count < 0 || mxIsNaN(count))
+    mexErrMsgTxt("Count must be nonnegative.");
+
+  /* Get the grids and the size of the product */
+  ndims = mxGetNumberOfElements(IN_GRIDS);
+  gridn = (mwSize *)mxCalloc(ndims > 0 ? ndims : 1, sizeof(mwSize));
+  ptrgrid = (double **)mxCalloc(ndims > 0 ? ndims : 1, sizeof(double *));
+  for (d = 0; d < ndims; d++) {
+    grid = mxGetCell(IN_GRIDS, d);
+    if (grid == NULL || !mxIsDouble(grid) || mxIsComplex(grid))
+      mexErrMsgTxt("Each grid must be a real double vector.");
+    gridn[d] = mxGetNumberOfElements(grid);
+    ptrgrid[d] = mxGetPr(grid);
+    ntotal *= (double)gridn[d];
+  }
+  if (ndims == 0) ntotal = 0;
+  if (ntotal > MAX_INDEX)
+    mexErrMsgTxt("Number of combinations exceeds flintmax.");
+  total = (uint64_T)ntotal;
+
+  /* Number of rows to return */
+  pos = (uint64_T)start - 1;
+  remain = pos < total ? (total - pos - 1) / stride + 1 : 0;
+  nrows = (mwSize)((double)remain < count ? (double)remain : count);
+
+  /* Derive the Feistel round keys and the half width of its domain */
+  if (seed != 0 && total > 1) {
+    permute = 1;
+    for (k = 0; k < NUM_ROUNDS; k++) keys[k] = splitmix64(&seed);
+    while (((uint64_T)1 << (2 * half)) < total) half++;
+  }
+
+  OUT_C = mxCreateDoubleMatrix(nrows, ndims, mxREAL);
+  ptrc = mxGetPr(OUT_C);
+  if (nlhs > 1) {
+    OUT_IDX = mxCreateDoubleMatrix(nrows, 1, mxREAL);
+    ptridx = mxGetPr(OUT_IDX);
+  }
+
+  /* Decode each position as a mixed radix number, last grid fastest */
+  for (i = 0; i < nrows; i++, pos += stride) {
+    lin = permute ? permute_index(pos, total, half, keys) : pos;
+    if (nlhs > 1) *(ptridx + i) = (double)lin + 1;
+    for (d = ndims; d-- > 0;) {
+      *(ptrc + d * nrows + i) = *(ptrgrid[d] + lin % gridn[d]);
+      lin /= gridn[d];
+    }
+  }
+
+  mxFree(gridn);
+  mxFree(ptrgrid);
+
+  return;
+}
@@ -0,0 +1,38 @@
+% Copyright 2022, MIT Lincoln Laboratory
+% SPDX-License-Identifier: BSD-2-Clause
+% Test sweep_chunk
+grids = {[100 150 200], 0:30:330, -1000:500:1000};
+A = allcomb(grids{:});
+n = size(A,1);
+
+%% Natural order matches allcomb
+[C, idx] = sweep_chunk(grids,1,inf);
+assert(isequal(C,A) && isequal(idx,(1:n)'),'Natural order does not match allcomb');
+
+% Resume from any position in chunks
+C = [sweep_chunk(grids,1,7); sweep_chunk(grids,8,50); sweep_chunk(grids,58,inf)];
+assert(isequal(C,A),'Chunked sweep does not match allcomb');
+
+%% Seeded order visits every index exactly once
+[C, idx] = sweep_chunk(grids,1,inf,[1 42]);
+assert(isequal(sort(idx),(1:n)'),'Seeded order is not a permutation');
+assert(isequal(C,A(idx,:)),'Seeded rows do not match their indices');
+
+% Not a fixed step walk
+steps = mod(diff(idx),n);
+assert(numel(unique(steps)) > 1,'Seeded order is a fixed step walk');
+
+% Strided shards see every value of the last grid
+stride = numel(grids{end});
+for w=1:1:stride
+    C = sweep_chunk(grids,w,inf,[stride 42]);
+    assert(numel(unique(C(:,end))) == numel(grids{end}),'Shard %i aliases the last grid',w);
+end
+
+% Shards partition the sweep
+idx = [];
+for w=1:1:stride
+    [~, idxShard] = sweep_chunk(grids,w,inf,[stride 42]);
+    idx = [idx; idxShard]; %#ok<AGROW>
+end
+assert(isequal(sort(idx),(1:n)'),'Strided shards do not partition the sweep');